@@ -17,6 +17,7 @@ let trtcCloud = null; // trtcCloud 单例
 export default class TrtcCloudImpl {
     constructor() {
         this.listenersMap_ = new Map();
+        this.renderParamsMap_ = new Map(); // 已下发的渲染参数，key 为 'local' 或 `${userId}_${streamType}`
     }
     static _createInstance() {
         try {
@@ -53,6 +54,16 @@ export default class TrtcCloudImpl {
             });
         }
     }
+    // 渲染参数与上次下发的相同时跳过 apply，避免重复调用原生接口
+    // apply 成功后才记录，原生调用抛错时下次相同参数仍会重试
+    applyRenderParams_(key, params, apply) {
+        const serialized = JSON.stringify(params);
+        if (this.renderParamsMap_.get(key) === serialized) {
+            return;
+        }
+        apply();
+        this.renderParamsMap_.set(key, serialized);
+    }
     // 截图保存
     // async saveImage_(base64Data) {
     //   return new Promise((resolve, reject) => {
@@ -90,20 +101,27 @@ export default class TrtcCloudImpl {
                 message: `${NAME.LOG_PREFIX} please check the on method parameter types. event type is a ${typeof event}; callback type is a ${typeof callback}`,
             });
         }
+        const listener = this.listenersMap_.get(event);
+        if (listener) {
+            listener.callbacks.add(callback);
+            return;
+        }
+        const callbacks = new Set([callback]);
+        // 每个事件只注册一个原生监听，数据解析一次后分发给所有 callback
         const nativeListener = (res) => __awaiter(this, void 0, void 0, function* () {
             const { data = [] } = res;
             const code = data[0];
             const message = data[1] || '';
             const extraInfo = data[2] || {};
+            let result;
             switch (event) {
                 case 'onEnterRoom': {
-                    const result = code;
-                    callback(result);
+                    result = code;
                     break;
                 }
                 case 'onExitRoom': {
                     const reason = code;
-                    callback(reason);
+                    result = reason;
                     break;
                 }
                 case 'onFirstVideoFrame': {
@@ -111,134 +129,140 @@ export default class TrtcCloudImpl {
                     const streamType = data[1] || 0;
                     const width = data[2] || 0;
                     const height = data[3] || 0;
-                    callback({ userId, streamType, width, height });
+                    result = { userId, streamType, width, height };
                     break;
                 }
                 case 'onFirstAudioFrame': {
                     const userId = code || '';
-                    callback(userId);
+                    result = userId;
                     break;
                 }
                 case 'onMicDidReady': {
-                    callback();
                     break;
                 }
                 case 'onCameraDidReady': {
-                    callback();
                     break;
                 }
                 case 'onNetworkQuality': {
                     const localQuality = data[0];
                     const remoteQuality = data[1];
-                    callback({ localQuality, remoteQuality });
+                    result = { localQuality, remoteQuality };
                     break;
                 }
                 case 'onRemoteUserEnterRoom': {
                     const userId = code || '';
-                    callback(userId);
+                    result = userId;
                     break;
                 }
                 case 'onRemoteUserLeaveRoom': {
                     const userId = code || '';
                     const reason = message;
-                    callback({ userId, reason });
+                    result = { userId, reason };
                     break;
                 }
                 case 'onSendFirstLocalAudioFrame': {
-                    callback();
                     break;
                 }
                 case 'onSendFirstLocalVideoFrame': {
                     const streamType = code;
-                    callback(streamType);
+                    result = streamType;
                     break;
                 }
                 case 'onStatistics': {
                     const statics = data[0] || {};
-                    callback(statics);
+                    result = statics;
                     break;
                 }
                 case 'onUserAudioAvailable': {
                     const userId = code || '';
                     const available = message;
-                    callback({ userId, available });
+                    result = { userId, available };
                     break;
                 }
                 case 'onUserVideoAvailable': {
                     const userId = code || '';
                     const available = message;
-                    callback({ userId, available });
+                    result = { userId, available };
                     break;
                 }
                 case 'onUserVoiceVolume': {
                     const userVolumes = data[0];
                     const totalVolume = data[1];
-                    callback({ userVolumes, totalVolume });
+                    result = { userVolumes, totalVolume };
                     break;
                 }
                 case 'onSwitchRole': {
-                    callback({ code, message });
+                    result = { code, message };
                     break;
                 }
                 case 'onScreenCaptureStarted': {
-                    callback({ code, message });
+                    result = { code, message };
                     break;
                 }
                 case 'onScreenCapturePaused': {
-                    callback({ code, message });
+                    result = { code, message };
                     break;
                 }
                 case 'onScreenCaptureResumed': {
-                    callback({ code, message });
+                    result = { code, message };
                     break;
                 }
                 case 'onScreenCaptureStopped': {
-                    callback({ code, message });
+                    result = { code, message };
                     break;
                 }
                 case 'onUserSubStreamAvailable': {
                     const userId = code || '';
                     const available = message;
-                    callback({ userId, available });
+                    result = { userId, available };
                     break;
                 }
                 case 'onSnapshotComplete': {
                     // base64 直接保存到本地图库
                     // const { code: snapShotCode, message: msg } = await this.saveImage_(code);
                     // callback({ snapShotCode, message: msg });
-                    callback({ base64Data: code, message });
+                    result = { base64Data: code, message };
                     break;
                 }
                 case 'onUserVideoSizeChanged': {
-                    callback(data);
+                    result = data;
                     break;
                 }
                 case 'onStart': {
-                    callback({ id: code, errCode: message });
+                    result = { id: code, errCode: message };
                     break;
                 }
                 case 'onPlayProgress': {
-                    callback({ id: code, curPtsMS: message, durationMS: extraInfo });
+                    result = { id: code, curPtsMS: message, durationMS: extraInfo };
                     break;
                 }
                 case 'onComplete': {
-                    callback({ id: code, errCode: message });
+                    result = { id: code, errCode: message };
                     break;
                 }
                 case 'onError': {
                     console.error(`onError: ${code}, ${message}, ${extraInfo}`);
-                    callback(generateError_({ message }, code, extraInfo));
+                    result = generateError_({ message }, code, extraInfo);
                     break;
                 }
                 default: {
-                    callback({ code, message, extraInfo });
+                    result = { code, message, extraInfo };
                 }
             }
+            // 单个 callback 抛错不影响其他 callback
+            callbacks.forEach((cb) => {
+                try {
+                    cb(result);
+                }
+                catch (error) {
+                    console.error(`${NAME.LOG_PREFIX} ${event} callback error: ${error}`);
+                }
+            });
         });
-        this.listenersMap_.set(event, nativeListener); // 多次设置同一个事件时，后面的 callback 覆盖前面
+        this.listenersMap_.set(event, { nativeListener, callbacks });
         TrtcEvent.addEventListener(event, nativeListener);
     }
-    off(event) {
+    off(event, callback) {
         if (typeof event !== NAME.STRING) {
             throw new TrtcError({
                 code: TXLiteJSError.INVALID_PARAMETER,
@@ -248,12 +272,19 @@ export default class TrtcCloudImpl {
         try {
             if (event === '*') {
                 this.listenersMap_.forEach((value, key) => {
-                    TrtcEvent.removeEventListener(key, value);
+                    TrtcEvent.removeEventListener(key, value.nativeListener);
                 });
                 this.listenersMap_.clear();
+                return;
             }
-            else {
-                TrtcEvent.removeEventListener(event, this.listenersMap_.get(event));
+            const listener = this.listenersMap_.get(event);
+            if (!listener) {
+                return;
+            }
+            // 传入 callback 时只解绑该 callback，最后一个 callback 解绑后才移除原生监听
+            callback ? listener.callbacks.delete(callback) : listener.callbacks.clear();
+            if (listener.callbacks.size === 0) {
+                TrtcEvent.removeEventListener(event, listener.nativeListener);
                 this.listenersMap_.delete(event);
             }
         }
@@ -278,6 +309,7 @@ export default class TrtcCloudImpl {
     }
     exitRoom() {
         try {
+            this.renderParamsMap_.clear();
             TrtcNativeTrtcCloudModule.exitRoom();
         }
         catch (error) {
@@ -308,6 +340,7 @@ export default class TrtcCloudImpl {
         try {
             let param = { isFrontCamera: !!isFrontCamera };
             param = viewId ? Object.assign(Object.assign({}, param), { userId: viewId }) : param;
+            this.renderParamsMap_.delete('local');
             TrtcNativeTrtcCloudModule.startLocalPreview(param);
         }
         catch (error) {
@@ -322,8 +355,23 @@ export default class TrtcCloudImpl {
             throw generateError_(error);
         }
     }
+    enableEncSmallVideoStream(enable, smallVideoEncParam = null) {
+        if (typeof enable !== NAME.BOOLEAN) {
+            throw new TrtcError({
+                code: TXLiteJSError.INVALID_PARAMETER,
+                message: `${NAME.LOG_PREFIX} please check the enableEncSmallVideoStream method parameters`,
+            });
+        }
+        try {
+            TrtcNativeTrtcCloudModule.enableEncSmallVideoStream(Object.assign({ enable }, smallVideoEncParam));
+        }
+        catch (error) {
+            throw generateError_(error);
+        }
+    }
     stopLocalPreview() {
         try {
+            this.renderParamsMap_.delete('local');
             TrtcNativeTrtcCloudModule.stopLocalPreview();
         }
         catch (error) {
@@ -347,11 +395,8 @@ export default class TrtcCloudImpl {
     setLocalRenderParams(params) {
         try {
             const { rotation = TRTCVideoRotation.TRTCVideoRotation_0, fillMode = TRTCVideoFillMode.TRTCVideoFillMode_Fill, mirrorType = TRTCVideoMirrorType.TRTCVideoMirrorType_Auto } = params;
-            TrtcNativeTrtcCloudModule.setLocalRenderParams({
-                rotation,
-                fillMode,
-                mirrorType,
-            });
+            const renderParams = { rotation, fillMode, mirrorType };
+            this.applyRenderParams_('local', renderParams, () => TrtcNativeTrtcCloudModule.setLocalRenderParams(renderParams));
         }
         catch (error) {
             throw generateError_(error);
@@ -379,6 +424,7 @@ export default class TrtcCloudImpl {
             });
         }
         try {
+            this.renderParamsMap_.delete(`${userId}_${streamType}`);
             TrtcNativeTrtcCloudModule.startRemoteView({ userId, streamType, viewId });
         }
         catch (error) {
@@ -393,6 +439,7 @@ export default class TrtcCloudImpl {
             });
         }
         try {
+            this.renderParamsMap_.delete(`${userId}_${streamType}`);
             TrtcNativeTrtcCloudModule.stopRemoteView({ userId, streamType });
         }
         catch (error) {
@@ -405,17 +452,17 @@ export default class TrtcCloudImpl {
             if (!userId || (streamType !== TRTCVideoStreamType.TRTCVideoStreamTypeBig && streamType !== TRTCVideoStreamType.TRTCVideoStreamTypeSub)) {
                 throw new TrtcError({
                     code: TXLiteJSError.INVALID_PARAMETER,
-                    message: `${NAME.LOG_PREFIX} please check the snapshotVideo method parameters`,
+                    message: `${NAME.LOG_PREFIX} please check the setRemoteRenderParams method parameters`,
                 });
             }
             const { rotation = TRTCVideoRotation.TRTCVideoRotation_0, fillMode = TRTCVideoFillMode.TRTCVideoFillMode_Fill, mirrorType = TRTCVideoMirrorType.TRTCVideoMirrorType_Auto } = params;
-            TrtcNativeTrtcCloudModule.setRemoteRenderParams({
+            this.applyRenderParams_(`${userId}_${streamType}`, { rotation, fillMode, mirrorType }, () => TrtcNativeTrtcCloudModule.setRemoteRenderParams({
                 userId,
                 streamType,
                 rotation,
                 fillMode,
                 mirrorType
-            });
+            }));
         }
         catch (error) {
             throw generateError_(error);
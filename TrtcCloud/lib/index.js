@@ -34,7 +34,8 @@ export default class TrtcCloud {
         return TrtcCloudImpl._destroyInstance();
     }
     /**
-     * 设置 TrtcCloud 事件监听
+     * 设置 TrtcCloud 事件监听<br>
+     * 同一事件可以绑定多个 callback，事件数据只解析一次并依次分发给各个 callback
      *
      * @param {String} event 事件名称
      * @param {Function} callback 事件回调
@@ -51,14 +52,17 @@ export default class TrtcCloud {
      * 取消事件绑定<br>
      *
      * @param {String} event 事件名称，传入通配符 '*' 会解除所有事件绑定。
+     * @param {Function=} callback 要解绑的事件回调，不传时解绑该事件的所有回调
      * @memberof TrtcCloud
      * @example
      * this.trtcCloud.off('onEnterRoom');
      *
+     * this.trtcCloud.off('onEnterRoom', onEnterRoomHandler); // 只取消指定的回调
+     *
      * this.trtcCloud.off('*'); // 取消所有绑定的事件
      */
-    off(event) {
-        return TrtcCloudImpl._getInstance().off(event);
+    off(event, callback) {
+        return TrtcCloudImpl._getInstance().off(event, callback);
     }
     /**
      * 进房<br>
@@ -192,6 +196,31 @@ export default class TrtcCloud {
     setVideoEncoderParam(param) {
         return TrtcCloudImpl._getInstance().setVideoEncoderParam(param);
     }
+    /**
+     * 开启大小画面双路编码模式<br>
+     * 开启后，当前用户的编码器会同时输出【高清大画面】和【低清小画面】两路视频流（但只有一路音频流），观众可以通过 startRemoteView 选择观看大画面或小画面。
+     *
+     * **Note:**
+     *  - 双路编码会额外消耗 CPU 和上行带宽，建议只在主播端开启。
+     *
+     * @param {Boolean} enable 是否开启小画面编码，默认值：false
+     * @param {TRTCVideoEncParam=} smallVideoEncParam 小流的视频参数
+     * @memberof TrtcCloud
+     * @example
+     * import { TRTCVideoResolution, TRTCVideoResolutionMode } from '@/TrtcCloud/lib/TrtcDefines';
+     * const smallVideoEncParam = {
+     *   videoResolution: TRTCVideoResolution.TRTCVideoResolution_320_180,
+     *   videoResolutionMode: TRTCVideoResolutionMode.TRTCVideoResolutionModePortrait,
+     *   videoFps: 15,
+     *   videoBitrate: 200,
+     *   minVideoBitrate: 100,
+     *   enableAdjustRes: false,
+     * };
+     * this.trtcCloud.enableEncSmallVideoStream(true, smallVideoEncParam);
+     */
+    enableEncSmallVideoStream(enable, smallVideoEncParam = null) {
+        return TrtcCloudImpl._getInstance().enableEncSmallVideoStream(enable, smallVideoEncParam);
+    }
     /**
      * 切换前置或后置摄像头
      *
@@ -302,7 +331,9 @@ export default class TrtcCloud {
      * };
      * this.trtcCloud.setRemoteRenderParams(userId, TRTCVideoStreamType.TRTCVideoStreamTypeBig, renderParams);
      */
-    setRemoteRenderParams(userId, streamType, params) { }
+    setRemoteRenderParams(userId, streamType, params) {
+        return TrtcCloudImpl._getInstance().setRemoteRenderParams(userId, streamType, params);
+    }
     /**
      * 视频画面截图
      *
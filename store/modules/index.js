@@ -2,9 +2,11 @@
 import { useLiveStore } from './live'
 import { useUserStore } from './user'
 import { useTrtcStore } from './trtc'
+import { useMusicStore } from './music'
 
 export {
   useLiveStore,
   useUserStore,
-  useTrtcStore
+  useTrtcStore,
+  useMusicStore
 }
\ No newline at end of file
@@ -0,0 +1,291 @@
+// store/modules/music.js
+import { defineStore } from 'pinia'
+import { useTrtcStore } from './trtc'
+
+// 本地缓存索引在 Storage 中的键名
+const CACHE_STORAGE_KEY = 'musicCacheIndex'
+
+// 将 uni.xxx 回调式接口包装为 Promise
+const callUni = (api, options) => new Promise((resolve, reject) => {
+  uni[api]({
+    ...options,
+    success: resolve,
+    fail: reject
+  })
+})
+
+// 音效 ID 从该值开始分配，避免与页面中手动指定的背景音乐 ID 冲突
+const EFFECT_ID_BASE = 1000
+
+// 下载中的请求，同一地址并发调用时复用同一个下载
+const pendingDownloads = {}
+
+// 歌词时间轴，解析一次后按时间排序存放，不放入 state 避免大数组被响应式代理
+const lyricTimeline = {
+  // 歌词对应的音乐 ID，其他音乐（如音效）的播放进度不驱动歌词
+  musicId: null,
+  times: [],
+  texts: []
+}
+
+// LRC 时间标签，如 [01:02.34]
+const LRC_TIME_TAG = /\[(\d+):(\d+)(?:[.:](\d+))?\]/g
+
+// 二分查找 time 所在的歌词行，返回开始时间不大于 time 的最后一行，没有则返回 -1
+const searchLyricIndex = (time) => {
+  const { times } = lyricTimeline
+  let low = 0
+  let high = times.length - 1
+  while (low <= high) {
+    const mid = (low + high) >> 1
+    if (times[mid] <= time) {
+      low = mid + 1
+    } else {
+      high = mid - 1
+    }
+  }
+  return high
+}
+
+export const useMusicStore = defineStore('music', {
+  state: () => ({
+    // 缓存索引：{ [url]: { savedFilePath, size, lastUsed, loadTime } }
+    cacheIndex: uni.getStorageSync(CACHE_STORAGE_KEY) || {},
+    // 缓存总大小上限（字节）
+    maxCacheSize: 200 * 1024 * 1024,
+    // 播放音乐时的缓存命中统计，预加载和音效不计入
+    cacheStats: {
+      hits: 0,
+      misses: 0
+    },
+    // 音效 ID 表：{ [url]: id }，同一音效始终使用同一个 ID
+    effectIds: {},
+    // 当前歌词行下标，-1 表示尚未开始
+    lyricIndex: -1,
+    // 错误信息
+    error: null
+  }),
+
+  getters: {
+    // 当前缓存总大小
+    cacheSize: (state) => Object.values(state.cacheIndex).reduce((total, item) => total + item.size, 0),
+
+    // 缓存命中率
+    cacheHitRate: (state) => {
+      const total = state.cacheStats.hits + state.cacheStats.misses
+      return total > 0 ? state.cacheStats.hits / total : 0
+    },
+
+    // 各曲目下载到本地的耗时（ms）：{ [url]: loadTime }
+    loadTimes: (state) => Object.entries(state.cacheIndex).reduce((result, [url, item]) => {
+      result[url] = item.loadTime
+      return result
+    }, {}),
+
+    // 当前歌词
+    currentLyric: (state) => lyricTimeline.texts[state.lyricIndex] || ''
+  },
+
+  actions: {
+    // 获取可直接传给 startPlayMusic 的路径
+    // 命中缓存时返回本地绝对路径；未命中时直接返回网络地址由 SDK 边下边播，同时在后台下载到本地，之后切歌直接命中本地文件
+    // 音效调用时 countStats 为 false，频繁触发的音效不计入音乐缓存命中率
+    async getMusicPath(url, countStats = true) {
+      if (!/^https?:\/\//.test(url)) {
+        return url
+      }
+
+      let cached = this.cacheIndex[url]
+      if (cached) {
+        try {
+          // 索引持久化在 Storage 中，文件可能已被用户或系统清理
+          await callUni('getFileInfo', { filePath: cached.savedFilePath })
+        } catch (error) {
+          delete this.cacheIndex[url]
+          this.saveCacheIndex()
+          cached = null
+        }
+      }
+      if (countStats) {
+        cached ? this.cacheStats.hits++ : this.cacheStats.misses++
+      }
+      if (cached) {
+        cached.lastUsed = Date.now()
+        this.saveCacheIndex()
+        return plus.io.convertLocalFileSystemURL(cached.savedFilePath)
+      }
+
+      // 不等待下载完成，避免首播等待整首歌下载
+      this.cacheMusic(url).catch(error => {
+        this.error = error.errMsg || error.message || '缓存音乐失败'
+      })
+      return url
+    },
+
+    // 下载音乐到本地缓存，同一地址并发调用时复用同一个下载，返回本地保存路径
+    cacheMusic(url, isPreload = false) {
+      if (!pendingDownloads[url]) {
+        pendingDownloads[url] = this.downloadMusic(url, isPreload).finally(() => {
+          delete pendingDownloads[url]
+        })
+      }
+      return pendingDownloads[url]
+    },
+
+    // 下载音乐并写入缓存
+    // 预加载不触发淘汰：放不下时丢弃刚下载的文件，避免挤掉已播放或排序更靠前的曲目
+    async downloadMusic(url, isPreload = false) {
+      const startTime = Date.now()
+      const { tempFilePath, statusCode } = await callUni('downloadFile', { url })
+      if (statusCode !== 200) {
+        throw new Error(`download music failed, statusCode = ${statusCode}`)
+      }
+      const { savedFilePath } = await callUni('saveFile', { tempFilePath })
+      const { size } = await callUni('getFileInfo', { filePath: savedFilePath })
+      if (isPreload && this.cacheSize + size > this.maxCacheSize) {
+        await callUni('removeSavedFile', { filePath: savedFilePath })
+        throw new Error('music cache is full, preload skipped')
+      }
+
+      this.cacheIndex[url] = {
+        savedFilePath,
+        size,
+        lastUsed: Date.now(),
+        // 下载并写入本地的耗时（ms）
+        loadTime: Date.now() - startTime
+      }
+      if (!isPreload) {
+        await this.evictCache()
+      }
+      this.saveCacheIndex()
+      return savedFilePath
+    },
+
+    // 超出缓存上限时按最近最少使用（LRU）淘汰
+    async evictCache() {
+      const entries = Object.entries(this.cacheIndex).sort((a, b) => a[1].lastUsed - b[1].lastUsed)
+      let total = this.cacheSize
+      // 至少保留最近使用的一项
+      for (let i = 0; i < entries.length - 1 && total > this.maxCacheSize; i++) {
+        const [url, item] = entries[i]
+        try {
+          await callUni('removeSavedFile', { filePath: item.savedFilePath })
+        } catch (error) {
+          // 文件已不存在时直接移除索引
+        }
+        delete this.cacheIndex[url]
+        total -= item.size
+      }
+    },
+
+    // 按优先级预加载即将播放的音乐，urls 按播放顺序排列
+    // 逐个下载，排序靠后的曲目不会先于靠前的写入缓存，也不会与正在播放的音乐争抢带宽
+    async preloadMusic(urls) {
+      const queue = urls.filter(url => /^https?:\/\//.test(url) && !this.cacheIndex[url])
+      for (let i = 0; i < queue.length; i++) {
+        // 当前缓存已满时停止预加载，避免淘汰更靠前的曲目
+        if (this.cacheSize >= this.maxCacheSize) {
+          return
+        }
+        try {
+          await this.cacheMusic(queue[i], true)
+        } catch (error) {
+          // 未能写入缓存（缓存已满或下载失败）时停止后续预加载
+          this.error = error.errMsg || error.message || '预加载音乐失败'
+          return
+        }
+      }
+    },
+
+    // 播放短音效（如音效板），同一音效重复触发时 SDK 会停止上一次播放并从头开始
+    // 按地址复用 ID，SDK 不必为每次触发重新加载文件
+    async playEffect(url, publish = true) {
+      if (this.effectIds[url] === undefined) {
+        this.effectIds[url] = EFFECT_ID_BASE + Object.keys(this.effectIds).length
+      }
+      const id = this.effectIds[url]
+      const path = await this.getMusicPath(url, false)
+
+      const trtcStore = useTrtcStore()
+      if (!trtcStore.trtcCloud) {
+        await trtcStore.initTrtc()
+      }
+      trtcStore.trtcCloud.startPlayMusic({
+        id,
+        path,
+        loopCount: 0,
+        publish,
+        isShortFile: true,
+        startTimeMS: 0,
+        endTimeMS: 0
+      })
+      return id
+    },
+
+    // 停止所有音效
+    stopAllEffects() {
+      const { trtcCloud } = useTrtcStore()
+      if (trtcCloud) {
+        Object.values(this.effectIds).forEach(id => trtcCloud.stopPlayMusic(id))
+      }
+    },
+
+    // 加载 musicId 对应音乐的 LRC 歌词
+    loadLyrics(musicId, lrcText) {
+      const lines = []
+      lrcText.split(/\r?\n/).forEach(line => {
+        const text = line.replace(LRC_TIME_TAG, '').trim()
+        // 一行可以带多个时间标签，表示同一句歌词在多个时间点出现
+        for (const match of line.matchAll(LRC_TIME_TAG)) {
+          const [, minutes, seconds, fraction = '0'] = match
+          const time = (+minutes * 60 + +seconds) * 1000 + Math.round(+`0.${fraction}` * 1000)
+          lines.push({ time, text })
+        }
+      })
+      lines.sort((a, b) => a.time - b.time)
+
+      lyricTimeline.musicId = musicId
+      lyricTimeline.times = lines.map(line => line.time)
+      lyricTimeline.texts = lines.map(line => line.text)
+      this.lyricIndex = -1
+    },
+
+    // 根据 onPlayProgress 的 id 和 curPtsMS 更新当前歌词行
+    // 顺序播放时只需检查当前行和下一行，拖动进度时才需要二分查找
+    updateLyricProgress(id, curPtsMS) {
+      if (id !== lyricTimeline.musicId) {
+        return
+      }
+      const { times } = lyricTimeline
+      const index = this.lyricIndex
+      const next = index + 1
+      if (index >= 0 && times[index] <= curPtsMS && (next >= times.length || curPtsMS < times[next])) {
+        return
+      }
+      if (next < times.length && times[next] <= curPtsMS && (next + 1 >= times.length || curPtsMS < times[next + 1])) {
+        this.lyricIndex = next
+        return
+      }
+      this.lyricIndex = searchLyricIndex(curPtsMS)
+    },
+
+    // 持久化缓存索引
+    saveCacheIndex() {
+      uni.setStorageSync(CACHE_STORAGE_KEY, this.cacheIndex)
+    },
+
+    // 清空缓存
+    async clearCache() {
+      const items = Object.values(this.cacheIndex)
+      for (let i = 0; i < items.length; i++) {
+        try {
+          await callUni('removeSavedFile', { filePath: items[i].savedFilePath })
+        } catch (error) {
+          // 忽略已被删除的文件
+        }
+      }
+      this.cacheIndex = {}
+      this.saveCacheIndex()
+    }
+  }
+})
@@ -1,6 +1,49 @@
 // store/modules/trtc.js
 import { defineStore } from 'pinia'
 import TrtcCloud from '@/TrtcCloud/lib/index';
+import { TRTCBeautyStyle, TRTCVideoResolution, TRTCVideoResolutionMode, TRTCVideoStreamType } from '@/TrtcCloud/lib/TrtcDefines';
+
+// 屏幕分享编码参数：固定帧率并抬高最低码率，避免屏幕内容突发变化时码率控制来回震荡
+const SCREEN_SHARE_ENC_PARAM = {
+  videoResolution: TRTCVideoResolution.TRTCVideoResolution_1280_720,
+  videoResolutionMode: TRTCVideoResolutionMode.TRTCVideoResolutionModePortrait,
+  videoFps: 10,
+  videoBitrate: 1200,
+  minVideoBitrate: 800,
+  enableAdjustRes: false,
+}
+
+// 主播端双路编码的小画面参数，观众下行网络差时切换到小画面观看
+const SMALL_STREAM_ENC_PARAM = {
+  videoResolution: TRTCVideoResolution.TRTCVideoResolution_320_180,
+  videoResolutionMode: TRTCVideoResolutionMode.TRTCVideoResolutionModePortrait,
+  videoFps: 15,
+  videoBitrate: 200,
+  minVideoBitrate: 100,
+  enableAdjustRes: false,
+}
+
+// 远端画面抽样状态，定时器等非响应式数据不放入 state
+let videoSampler = null
+
+// 网络质量取值：0 未知，1 最好，2 好，3 一般，4 差，5 很差，6 不可用
+const NETWORK_QUALITY_POOR = 4
+const NETWORK_QUALITY_GOOD = 2
+// 连续多少次质量报告（每 2 秒一次）满足条件才切换流类型，降级快、升级慢，避免来回切换
+const STREAM_DOWNGRADE_REPORTS = 2
+const STREAM_UPGRADE_REPORTS = 5
+
+// 远端流类型自适应的计数状态
+const streamTypeAdapter = {
+  poorReports: 0,
+  goodReports: 0
+}
+
+// 切换流类型的开始时间，key 为 userId，收到新流首帧时计算切换耗时
+const streamSwitchStartTime = {}
+
+// 网络质量回调中的单项可能是数值或 { userId, quality }
+const qualityOf = (info) => (info && typeof info === 'object' ? info.quality : info) || 0
 
 export const useTrtcStore = defineStore('trtc', {
   state: () => ({
@@ -17,6 +60,13 @@ export const useTrtcStore = defineStore('trtc', {
     },
     // 远程流列表
     remoteStreams: [],
+    // 是否根据下行网络自动切换大小画面
+    // 依赖主播端开启双路编码（joinRoom 以主播身份进房时开启），主播未开启时应关闭，否则切换只会让大画面重新拉流
+    adaptiveStreamTypeEnabled: true,
+    // 观看远端画面时使用的流类型，下行网络差时切换为小画面
+    remoteStreamType: TRTCVideoStreamType.TRTCVideoStreamTypeBig,
+    // 最近一次大小流切换的耗时（ms），从发起切换到新流首帧渲染
+    streamSwitchLatency: 0,
     // 连接状态
     connectionState: 'disconnected', // disconnected, connecting, connected
     // 网络质量
@@ -55,9 +105,11 @@ export const useTrtcStore = defineStore('trtc', {
         this.error = null
 
         // 初始化TRTC实例
-        if (!this.trtcCloud) {
+        // createInstance 返回当前单例；其他页面调用 destroyInstance 后单例会被重建，此时不能再复用旧实例
+        const trtcCloud = TrtcCloud.createInstance()
+        if (this.trtcCloud !== trtcCloud) {
           // 在uni-app中获取TRTC插件实例
-          this.trtcCloud = TrtcCloud.createInstance()
+          this.trtcCloud = trtcCloud
           this.handleEvents();
         }
         return {
@@ -108,6 +160,13 @@ export const useTrtcStore = defineStore('trtc', {
       });
       this.trtcCloud.on('onFirstVideoFrame', (res) => {
         console.log(`渲染的首帧画面响应 = ${JSON.stringify(res)}`);
+        // 只统计切换后目标流的首帧，切换前旧流的首帧不计入
+        const startTime = res.userId && streamSwitchStartTime[res.userId]
+        if (startTime && res.streamType === this.remoteStreamType) {
+          this.streamSwitchLatency = Date.now() - startTime
+          delete streamSwitchStartTime[res.userId]
+          console.log(`大小画面切换耗时: userId = ${res.userId}, streamType = ${res.streamType}, ${this.streamSwitchLatency}ms`);
+        }
       });
       this.trtcCloud.on('onRemoteUserEnterRoom', (userId) => {
         this.remoteUserId = userId;
@@ -116,6 +175,15 @@ export const useTrtcStore = defineStore('trtc', {
           icon: 'none',
         });
       });
+      this.trtcCloud.on('onNetworkQuality', ({ localQuality, remoteQuality }) => {
+        const remoteList = Array.isArray(remoteQuality) ? remoteQuality : [remoteQuality]
+        this.updateNetworkQuality({
+          uplink: qualityOf(localQuality),
+          // 下行质量取各路远端中最差的一路
+          downlink: Math.max(0, ...remoteList.map(qualityOf))
+        })
+        this.adaptRemoteStreamType()
+      });
       this.trtcCloud.on('onUserVideoAvailable', (res) => {
         const {
           userId,
@@ -125,6 +193,9 @@ export const useTrtcStore = defineStore('trtc', {
         if (userId && available) {
           this.remoteUserId = userId;
         }
+        if (userId) {
+          available ? this.addRemoteStream({ userId }) : this.removeRemoteStream(userId)
+        }
       });
     },
     // 创建本地预览
@@ -211,6 +282,11 @@ export const useTrtcStore = defineStore('trtc', {
           role: role === 'anchor' ? 20 : 21, // 20是主播，21是观众
         }
 
+        // 主播同时编码小画面，供网络差的观众切换观看
+        if (role === 'anchor') {
+          this.trtcCloud.enableEncSmallVideoStream(true, SMALL_STREAM_ENC_PARAM)
+        }
+
         // 进入房间
         this.trtcCloud.enterRoom(param)
 
@@ -238,6 +314,8 @@ export const useTrtcStore = defineStore('trtc', {
         this.loading = true
         this.error = null
 
+        this.stopVideoSampling()
+
         if (this.trtcCloud && this.connectionState === 'connected') {
           // 使用TRTC API离开房间
           this.trtcCloud.exitRoom()
@@ -248,6 +326,11 @@ export const useTrtcStore = defineStore('trtc', {
 
         // 清空远程流列表
         this.remoteStreams = []
+        this.remoteStreamType = TRTCVideoStreamType.TRTCVideoStreamTypeBig
+        streamTypeAdapter.poorReports = 0
+        streamTypeAdapter.goodReports = 0
+        Object.keys(streamSwitchStartTime).forEach(userId => delete streamSwitchStartTime[userId])
+        this.streamSwitchLatency = 0
 
         // 重置房间ID
         this.roomId = ''
@@ -329,8 +412,17 @@ export const useTrtcStore = defineStore('trtc', {
         this.loading = true
         this.error = null
 
-        // 这里可以添加实际的开启/关闭屏幕共享逻辑
-        // 例如：enabled ? this.trtcCloud.startScreenCapture() : this.trtcCloud.stopScreenCapture()
+        if (!this.trtcCloud) {
+          await this.initTrtc()
+        }
+
+        if (enabled) {
+          // 屏幕分享走辅路，startScreenCapture 会一并设置辅路编码参数
+          this.trtcCloud.startScreenCapture(TRTCVideoStreamType.TRTCVideoStreamTypeSub, SCREEN_SHARE_ENC_PARAM)
+        } else {
+          this.trtcCloud.stopScreenCapture()
+        }
+
         // 更新本地流状态
         this.localStream.screenShareEnabled = enabled
         return {
@@ -346,6 +438,31 @@ export const useTrtcStore = defineStore('trtc', {
         this.loading = false
       }
     },
+    // 设置美颜
+    // 美颜在 SDK 的采集处理链路中完成，无需在 JS 层逐帧处理
+    async setBeauty(level, style = TRTCBeautyStyle.TRTCBeautyStyleSmooth) {
+      try {
+        this.error = null
+
+        if (!this.trtcCloud) {
+          await this.initTrtc()
+        }
+
+        // 先设置级别再设置风格，级别为 0 表示关闭美颜
+        this.trtcCloud.setBeautyLevel(level)
+        this.trtcCloud.setBeautyStyle(style)
+
+        return {
+          success: true
+        }
+      } catch (error) {
+        this.error = error.message || '设置美颜失败'
+        return {
+          success: false,
+          error: this.error
+        }
+      }
+    },
     // 切换摄像头
     async switchCamera() {
       try {
@@ -433,7 +550,9 @@ export const useTrtcStore = defineStore('trtc', {
 
     // 添加远程流
     addRemoteStream(stream) {
-      this.remoteStreams.push(stream)
+      if (!this.remoteStreams.some(item => item.userId === stream.userId)) {
+        this.remoteStreams.push(stream)
+      }
     },
 
     // 移除远程流
@@ -444,11 +563,124 @@ export const useTrtcStore = defineStore('trtc', {
       }
     },
 
+    // 开始远端画面抽样（如内容审核），目前仅提供 store 接口，页面尚未调用
+    // interval 是整个房间的截图间隔，各路远端流轮流截图，远端流再多 CPU 开销也保持不变
+    startVideoSampling(onSample, interval = 2000) {
+      this.stopVideoSampling()
+      if (!this.trtcCloud) {
+        return
+      }
+
+      const sampler = {
+        index: 0,
+        pendingUserId: null,
+        pendingTime: 0,
+        // 截图超时后暂停到该时间再发起下一张，期间迟到的回调没有对应的 pendingUserId，会被直接丢弃
+        resumeTime: 0,
+        timer: null,
+        onSnapshot: null
+      }
+      // 截图回调不带 userId，因此同一时间只允许一张截图在途
+      sampler.onSnapshot = ({ base64Data }) => {
+        const userId = sampler.pendingUserId
+        sampler.pendingUserId = null
+        if (userId && base64Data) {
+          onSample({ userId, base64Data, timestamp: Date.now() })
+        }
+      }
+      sampler.timer = setInterval(() => {
+        const now = Date.now()
+        // 上一张截图未返回时跳过本轮，超时则丢弃
+        if (sampler.pendingUserId && now - sampler.pendingTime < interval * 3) {
+          return
+        }
+        if (sampler.pendingUserId) {
+          sampler.pendingUserId = null
+          sampler.resumeTime = now + interval
+        }
+        if (now < sampler.resumeTime || this.remoteStreams.length === 0) {
+          return
+        }
+        const { userId } = this.remoteStreams[sampler.index % this.remoteStreams.length]
+        sampler.index++
+        try {
+          this.trtcCloud.snapshotVideo(userId, TRTCVideoStreamType.TRTCVideoStreamTypeBig)
+        } catch (error) {
+          console.log('snapshotVideo failed: ', error)
+          return
+        }
+        sampler.pendingUserId = userId
+        sampler.pendingTime = now
+      }, interval)
+
+      this.trtcCloud.on('onSnapshotComplete', sampler.onSnapshot)
+      videoSampler = sampler
+    },
+
+    // 停止远端画面抽样
+    stopVideoSampling() {
+      if (!videoSampler) {
+        return
+      }
+      clearInterval(videoSampler.timer)
+      if (this.trtcCloud) {
+        this.trtcCloud.off('onSnapshotComplete', videoSampler.onSnapshot)
+      }
+      videoSampler = null
+    },
+
     // 更新网络质量
     updateNetworkQuality(quality) {
       this.networkQuality = quality
     },
 
+    // 观看远端画面
+    startRemoteView(userId, viewId) {
+      if (!this.trtcCloud || !userId || !viewId) {
+        return
+      }
+      const stream = this.remoteStreams.find(item => item.userId === userId)
+      if (stream) {
+        stream.viewId = viewId
+      } else {
+        this.addRemoteStream({ userId, viewId })
+      }
+      this.trtcCloud.startRemoteView(userId, this.remoteStreamType, viewId)
+    },
+
+    // 根据下行网络质量在大画面和小画面之间切换
+    adaptRemoteStreamType() {
+      if (!this.adaptiveStreamTypeEnabled) {
+        return
+      }
+      const { downlink } = this.networkQuality
+      const { TRTCVideoStreamTypeBig, TRTCVideoStreamTypeSmall } = TRTCVideoStreamType
+      streamTypeAdapter.poorReports = downlink >= NETWORK_QUALITY_POOR ? streamTypeAdapter.poorReports + 1 : 0
+      streamTypeAdapter.goodReports = downlink > 0 && downlink <= NETWORK_QUALITY_GOOD ? streamTypeAdapter.goodReports + 1 : 0
+
+      let streamType = this.remoteStreamType
+      if (streamType === TRTCVideoStreamTypeBig && streamTypeAdapter.poorReports >= STREAM_DOWNGRADE_REPORTS) {
+        streamType = TRTCVideoStreamTypeSmall
+      } else if (streamType === TRTCVideoStreamTypeSmall && streamTypeAdapter.goodReports >= STREAM_UPGRADE_REPORTS) {
+        streamType = TRTCVideoStreamTypeBig
+      }
+      if (streamType === this.remoteStreamType) {
+        return
+      }
+
+      const previousType = this.remoteStreamType
+      this.remoteStreamType = streamType
+      streamTypeAdapter.poorReports = 0
+      streamTypeAdapter.goodReports = 0
+      this.remoteStreams.forEach(({ userId, viewId }) => {
+        if (viewId) {
+          streamSwitchStartTime[userId] = Date.now()
+          this.trtcCloud.stopRemoteView(userId, previousType)
+          this.trtcCloud.startRemoteView(userId, streamType, viewId)
+        }
+      })
+    },
+
     // 销毁TRTC
     async destroyTrtc() {
       try {
@@ -460,7 +692,12 @@ export const useTrtcStore = defineStore('trtc', {
           await this.leaveRoom()
         }
 
-        // 这里可以添加实际的销毁TRTC逻辑
+        this.stopVideoSampling()
+
+        // 原生实例保持常驻，下次开播/进房无需重新创建，只解绑本次注册的事件，避免回调重复
+        if (this.trtcCloud) {
+          this.trtcCloud.off('*')
+        }
 
         // 重置状态
         this.trtcCloud = null